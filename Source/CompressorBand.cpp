@@ -13,22 +13,29 @@ void CompressorBand::updateCompressorSettings()
     compressor.setAttack(attack->get());
     compressor.setRelease(release->get());
     compressor.setThreshold(threshold->get());
-    compressor.setRatio(ratio->getCurrentChoiceName().getFloatValue());
+    compressor.setRatio(sharedResources->ratioValues[static_cast<size_t>(ratio->getIndex())]);
 }
 
 void CompressorBand::process(juce::AudioBuffer<float>& buffer)
 {
-    if (mute->get())
-    {
-        buffer.clear();
-        return;
-    }
-
     auto block = juce::dsp::AudioBlock<float>(buffer);
     auto context = juce::dsp::ProcessContextReplacing<float>(block);
 
-    context.isBypassed = bypass->get();
-
     compressor.process(context);
 }
 
+bool CompressorBand::needsProcessing() const
+{
+    return !mute->get() && !bypass->get();
+}
+
+bool CompressorBand::isAudible(bool anyBandSoloed) const
+{
+    if (mute->get())
+    {
+        return false;
+    }
+
+    return !anyBandSoloed || solo->get();
+}
+
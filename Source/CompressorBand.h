@@ -1,6 +1,7 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "SharedResources.h"
 
 class CompressorBand
 {
@@ -9,6 +10,11 @@ public:
     void updateCompressorSettings();
     void process(juce::AudioBuffer<float>& buffer);
 
+    // These are only evaluated when the band configuration changes,
+    // process() itself no longer looks at mute/bypass.
+    bool needsProcessing() const;
+    bool isAudible(bool anyBandSoloed) const;
+
     juce::AudioParameterFloat* attack{ nullptr };
     juce::AudioParameterFloat* release{ nullptr };
     juce::AudioParameterFloat* threshold{ nullptr };
@@ -17,6 +23,9 @@ public:
     juce::AudioParameterBool* mute{ nullptr };
     juce::AudioParameterBool* solo{ nullptr };
 
+    // Owned by the processor, which keeps it alive for as long as its bands.
+    const SharedResources* sharedResources{ nullptr };
+
 private:
     juce::dsp::Compressor<float> compressor;
 };
\ No newline at end of file
@@ -23,24 +23,28 @@ SimpleMBCompAudioProcessor::SimpleMBCompAudioProcessor()
 #endif
 {
     using namespace params;
-    const auto& params = getParams();
 
-    auto setFloatParam = [&apvts = this->apvts, &params](auto& param, const auto& paramName)
+    // The layout is built by createParameterLayout(), so the types are known;
+    // the dynamic_cast is only there to catch mistakes in debug builds.
+    auto setFloatParam = [&apvts = this->apvts](auto& param, const auto& paramName)
     {
-        param = dynamic_cast<juce::AudioParameterFloat*>(apvts.getParameter(params.at(paramName)));
-        jassert(param != nullptr);
+        auto* parameter = apvts.getParameter(getParamId(paramName));
+        jassert(dynamic_cast<juce::AudioParameterFloat*>(parameter) != nullptr);
+        param = static_cast<juce::AudioParameterFloat*>(parameter);
     };
 
-    auto setChoiceParam = [&apvts = this->apvts, &params](auto& param, const auto& paramName)
+    auto setChoiceParam = [&apvts = this->apvts](auto& param, const auto& paramName)
     {
-        param = dynamic_cast<juce::AudioParameterChoice*>(apvts.getParameter(params.at(paramName)));
-        jassert(param != nullptr);
+        auto* parameter = apvts.getParameter(getParamId(paramName));
+        jassert(dynamic_cast<juce::AudioParameterChoice*>(parameter) != nullptr);
+        param = static_cast<juce::AudioParameterChoice*>(parameter);
     };
 
-    auto setBoolParam = [&apvts = this->apvts, &params](auto& param, const auto& paramName)
+    auto setBoolParam = [&apvts = this->apvts](auto& param, const auto& paramName)
     {
-        param = dynamic_cast<juce::AudioParameterBool*>(apvts.getParameter(params.at(paramName)));
-        jassert(param != nullptr);
+        auto* parameter = apvts.getParameter(getParamId(paramName));
+        jassert(dynamic_cast<juce::AudioParameterBool*>(parameter) != nullptr);
+        param = static_cast<juce::AudioParameterBool*>(parameter);
     };
     
 
@@ -66,6 +70,11 @@ SimpleMBCompAudioProcessor::SimpleMBCompAudioProcessor()
     setBoolParam(midBandComp.solo, Names::SOLO_MID);
     setBoolParam(highBandComp.solo, Names::SOLO_HIGH);
 
+    for (auto& band : compressorBands)
+    {
+        band.sharedResources = &sharedResources.getObject();
+    }
+
     setFloatParam(lowMidCrossoverFreq, Names::LOW_MID_CROSSOVER_FREQ);
     setFloatParam(midHighCrossoverFreq, Names::MID_HIGH_CROSSOVER_FREQ);
     setBoolParam(globalBypass, Names::BYPASS_GLOBAL);
@@ -75,10 +84,27 @@ SimpleMBCompAudioProcessor::SimpleMBCompAudioProcessor()
     lowpass1.setType(juce::dsp::LinkwitzRileyFilterType::lowpass);
     highpass1.setType(juce::dsp::LinkwitzRileyFilterType::highpass);
     allpass1.setType(juce::dsp::LinkwitzRileyFilterType::allpass);
+
+    for (auto name : { Names::BYPASS_GLOBAL,
+                       Names::BYPASS_LOW, Names::BYPASS_MID, Names::BYPASS_HIGH,
+                       Names::MUTE_LOW, Names::MUTE_MID, Names::MUTE_HIGH,
+                       Names::SOLO_LOW, Names::SOLO_MID, Names::SOLO_HIGH })
+    {
+        apvts.addParameterListener(getParamId(name), this);
+    }
 }
 
 SimpleMBCompAudioProcessor::~SimpleMBCompAudioProcessor()
 {
+    using namespace params;
+
+    for (auto name : { Names::BYPASS_GLOBAL,
+                       Names::BYPASS_LOW, Names::BYPASS_MID, Names::BYPASS_HIGH,
+                       Names::MUTE_LOW, Names::MUTE_MID, Names::MUTE_HIGH,
+                       Names::SOLO_LOW, Names::SOLO_MID, Names::SOLO_HIGH })
+    {
+        apvts.removeParameterListener(getParamId(name), this);
+    }
 }
 
 //==============================================================================
@@ -167,6 +193,9 @@ void SimpleMBCompAudioProcessor::prepareToPlay (double sampleRate, int samplesPe
     {
         buffer.setSize(spec.numChannels, samplesPerBlock);
     }
+
+    numProcessChannels = static_cast<int>(spec.numChannels);
+    bandConfigChanged = true;
 }
 
 void SimpleMBCompAudioProcessor::releaseResources()
@@ -216,6 +245,29 @@ void SimpleMBCompAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer,
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
         buffer.clear (i, 0, buffer.getNumSamples());
 
+    jassert(buffer.getNumChannels() == numProcessChannels);
+
+    if (bandConfigChanged.exchange(false))
+    {
+        updateBandDispatch();
+    }
+
+    splitBands(buffer);
+
+    jassert(compressorBands.size() == filterBuffers.size());
+
+    for (size_t i = 0; i < numActiveBands; i++)
+    {
+        auto band = activeBands[i];
+        compressorBands[band].updateCompressorSettings();
+        compressorBands[band].process(filterBuffers[band]);
+    }
+
+    (this->*sumActiveBands)(buffer);
+}
+
+void SimpleMBCompAudioProcessor::splitBands(const juce::AudioBuffer<float>& buffer)
+{
     filterBuffers[0] = buffer;
     filterBuffers[1] = buffer;
 
@@ -239,55 +291,86 @@ void SimpleMBCompAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer,
     lowpass0.process(fb0Ctx);
     highpass0.process(fb1Ctx);
 
-    buffer.clear();
-
-    auto numSamples = buffer.getNumSamples();
-    auto numChannels = buffer.getNumChannels();
-
-    auto addToBuffer = [ns = numSamples, nc = numChannels](juce::AudioBuffer<float>& dest, const auto& source)
-    {
-        for (int i = 0; i < nc; i++)
-        {
-            dest.addFrom(i, 0, source, i, 0, ns);
-        }
-    };
-
     filterBuffers[2] = filterBuffers[1];
 
     lowpass1.process(fb1Ctx);
     highpass1.process(fb2Ctx);
     allpass1.process(fb0Ctx);
+}
 
-    jassert(compressorBands.size() == filterBuffers.size());
+void SimpleMBCompAudioProcessor::parameterChanged(const juce::String& parameterID, float newValue)
+{
+    juce::ignoreUnused(parameterID, newValue);
+    bandConfigChanged = true;
+}
+
+void SimpleMBCompAudioProcessor::updateBandDispatch()
+{
+    jassert(numProcessChannels == 1 || numProcessChannels == 2);
+
+    numActiveBands = 0;
+    int bandMask = 0;
 
     if (globalBypass->get())
     {
-        for (auto i = 0; i < filterBuffers.size(); i++)
+        bandMask = 0b111;
+    }
+    else
+    {
+        bool isSoloed = false;
+        for (const auto& band : compressorBands)
         {
-            addToBuffer(buffer, filterBuffers[i]);
+            isSoloed |= band.solo->get();
         }
-        return;
-    }
 
-    bool isSoloed = false;
-    for (auto i = 0; i < compressorBands.size(); i++)
-    {
-        compressorBands[i].updateCompressorSettings();
-        compressorBands[i].process(filterBuffers[i]);
-        isSoloed |= compressorBands[i].solo->get();
+        for (size_t i = 0; i < compressorBands.size(); i++)
+        {
+            if (compressorBands[i].needsProcessing())
+            {
+                activeBands[numActiveBands++] = i;
+            }
+
+            if (compressorBands[i].isAudible(isSoloed))
+            {
+                bandMask |= 1 << i;
+            }
+        }
     }
 
-    for (auto i = 0; i < filterBuffers.size(); i++)
+    sumActiveBands = sumBandsTable[numProcessChannels == 1 ? 0 : 1][bandMask];
+}
+
+template <int NumChannels, int BandMask>
+void SimpleMBCompAudioProcessor::sumBands(juce::AudioBuffer<float>& buffer)
+{
+    auto numSamples = buffer.getNumSamples();
+
+    for (int ch = 0; ch < NumChannels; ch++)
     {
-        if (isSoloed && !compressorBands[i].solo->get())
+        auto* dest = buffer.getWritePointer(ch);
+        const auto* low = filterBuffers[0].getReadPointer(ch);
+        const auto* mid = filterBuffers[1].getReadPointer(ch);
+        const auto* high = filterBuffers[2].getReadPointer(ch);
+
+        for (int i = 0; i < numSamples; i++)
         {
-            continue;
-        }
+            auto sum = 0.0f;
 
-        addToBuffer(buffer, filterBuffers[i]);
+            if constexpr ((BandMask & 0b001) != 0) sum += low[i];
+            if constexpr ((BandMask & 0b010) != 0) sum += mid[i];
+            if constexpr ((BandMask & 0b100) != 0) sum += high[i];
+
+            dest[i] = sum;
+        }
     }
 }
 
+const SimpleMBCompAudioProcessor::SumBandsTable SimpleMBCompAudioProcessor::sumBandsTable =
+{
+    makeSumBandsRow<1>(std::make_index_sequence<8>()),
+    makeSumBandsRow<2>(std::make_index_sequence<8>()),
+};
+
 //==============================================================================
 bool SimpleMBCompAudioProcessor::hasEditor() const
 {
@@ -330,24 +413,22 @@ juce::AudioProcessorValueTreeState::ParameterLayout SimpleMBCompAudioProcessor::
     using namespace params;
     APVTS::ParameterLayout layout;
 
-    const auto& params = getParams();
-
     //==============================================================================
 
     layout.add(std::make_unique<AudioParameterBool>(
-        params.at(Names::BYPASS_GLOBAL),
-        params.at(Names::BYPASS_GLOBAL),
+        getParamId(Names::BYPASS_GLOBAL),
+        getParamId(Names::BYPASS_GLOBAL),
         false));
 
     layout.add(std::make_unique<AudioParameterFloat>(
-        params.at(Names::LOW_MID_CROSSOVER_FREQ),
-        params.at(Names::LOW_MID_CROSSOVER_FREQ),
+        getParamId(Names::LOW_MID_CROSSOVER_FREQ),
+        getParamId(Names::LOW_MID_CROSSOVER_FREQ),
         NormalisableRange<float>(20, 20000, 1, 0.25),
         500));
 
     layout.add(std::make_unique<AudioParameterFloat>(
-        params.at(Names::MID_HIGH_CROSSOVER_FREQ),
-        params.at(Names::MID_HIGH_CROSSOVER_FREQ),
+        getParamId(Names::MID_HIGH_CROSSOVER_FREQ),
+        getParamId(Names::MID_HIGH_CROSSOVER_FREQ),
         NormalisableRange<float>(20, 20000, 1, 0.5),
         3000));
 
@@ -357,112 +438,108 @@ juce::AudioProcessorValueTreeState::ParameterLayout SimpleMBCompAudioProcessor::
     auto releaseRange = NormalisableRange<float>(1, 500, 1, 1);
     auto thresholdRange = NormalisableRange<float>(-60, 12, 1, 1);
 
-    auto ratioChoices = std::vector<double>{ 1, 1.5, 2, 3, 4, 5, 6, 8, 12, 16, 24, 32, 64, 128 };
-    juce::StringArray sa;
-    for (auto choice : ratioChoices)
-    {
-        sa.add(juce::String(choice, 1));
-    }
+    juce::SharedResourcePointer<SharedResources> sharedResources;
+    const auto& sa = sharedResources->ratioChoiceNames;
 
     //==============================================================================
 
     layout.add(std::make_unique<AudioParameterFloat>(
-        params.at(Names::THRESHOLD_LOW),
-        params.at(Names::THRESHOLD_LOW),
+        getParamId(Names::THRESHOLD_LOW),
+        getParamId(Names::THRESHOLD_LOW),
         thresholdRange,
         0));
     layout.add(std::make_unique<AudioParameterFloat>(
-        params.at(Names::ATTACK_LOW),
-        params.at(Names::ATTACK_LOW),
+        getParamId(Names::ATTACK_LOW),
+        getParamId(Names::ATTACK_LOW),
         attackRange,
         50));
     layout.add(std::make_unique<AudioParameterFloat>(
-        params.at(Names::RELEASE_LOW),
-        params.at(Names::RELEASE_LOW),
+        getParamId(Names::RELEASE_LOW),
+        getParamId(Names::RELEASE_LOW),
         releaseRange,
         250));
     layout.add(std::make_unique<AudioParameterChoice>(
-        params.at(Names::RATIO_LOW),
-        params.at(Names::RATIO_LOW),
+        getParamId(Names::RATIO_LOW),
+        getParamId(Names::RATIO_LOW),
         sa,
         3));
     layout.add(std::make_unique<AudioParameterBool>(
-        params.at(Names::BYPASS_LOW),
-        params.at(Names::BYPASS_LOW),
+        getParamId(Names::BYPASS_LOW),
+        getParamId(Names::BYPASS_LOW),
         false));
     layout.add(std::make_unique<AudioParameterBool>(
-        params.at(Names::MUTE_LOW),
-        params.at(Names::MUTE_LOW),
+        getParamId(Names::MUTE_LOW),
+        getParamId(Names::MUTE_LOW),
         false));
     layout.add(std::make_unique<AudioParameterBool>(
-        params.at(Names::SOLO_LOW),
-        params.at(Names::SOLO_LOW),
+        getParamId(Names::SOLO_LOW),
+        getParamId(Names::SOLO_LOW),
         false));
 
     layout.add(std::make_unique<AudioParameterFloat>(
-        params.at(Names::THRESHOLD_MID),
-        params.at(Names::THRESHOLD_MID),
+        getParamId(Names::THRESHOLD_MID),
+        getParamId(Names::THRESHOLD_MID),
         thresholdRange,
         0));
     layout.add(std::make_unique<AudioParameterFloat>(
-        params.at(Names::ATTACK_MID),
-        params.at(Names::ATTACK_MID),
+        getParamId(Names::ATTACK_MID),
+        getParamId(Names::ATTACK_MID),
         attackRange,
         50));
     layout.add(std::make_unique<AudioParameterFloat>(
-        params.at(Names::RELEASE_MID),
-        params.at(Names::RELEASE_MID),
+        getParamId(Names::RELEASE_MID),
+        getParamId(Names::RELEASE_MID),
         releaseRange,
         250));
     layout.add(std::make_unique<AudioParameterChoice>(
-        params.at(Names::RATIO_MID),
-        params.at(Names::RATIO_MID),
+        getParamId(Names::RATIO_MID),
+        getParamId(Names::RATIO_MID),
         sa,
         3));
     layout.add(std::make_unique<AudioParameterBool>(
-        params.at(Names::BYPASS_MID),
-        params.at(Names::BYPASS_MID),
+        getParamId(Names::BYPASS_MID),
+        getParamId(Names::BYPASS_MID),
         false));
     layout.add(std::make_unique<AudioParameterBool>(
-        params.at(Names::MUTE_MID),
-        params.at(Names::MUTE_MID),
+        getParamId(Names::MUTE_MID),
+        getParamId(Names::MUTE_MID),
         false));
     layout.add(std::make_unique<AudioParameterBool>(
-        params.at(Names::SOLO_MID),
-        params.at(Names::SOLO_MID),
+        getParamId(Names::SOLO_MID),
+        getParamId(Names::SOLO_MID),
         false));
 
     layout.add(std::make_unique<AudioParameterFloat>(
-        params.at(Names::THRESHOLD_HIGH),
-        params.at(Names::THRESHOLD_HIGH),
+        getParamId(Names::THRESHOLD_HIGH),
+        getParamId(Names::THRESHOLD_HIGH),
         thresholdRange,
         0));
     layout.add(std::make_unique<AudioParameterFloat>(
-        params.at(Names::ATTACK_HIGH),
-        params.at(Names::ATTACK_HIGH),
+        getParamId(Names::ATTACK_HIGH),
+        getParamId(Names::ATTACK_HIGH),
         attackRange,
         50));
     layout.add(std::make_unique<AudioParameterFloat>(
-        params.at(Names::RELEASE_HIGH),
-        params.at(Names::RELEASE_HIGH),
+        getParamId(Names::RELEASE_HIGH),
+        getParamId(Names::RELEASE_HIGH),
         releaseRange,
         250));
     layout.add(std::make_unique<AudioParameterChoice>(
-        params.at(Names::RATIO_HIGH),
-        params.at(Names::RATIO_HIGH),
+        getParamId(Names::RATIO_HIGH),
+        getParamId(Names::RATIO_HIGH),
         sa,
         3));
     layout.add(std::make_unique<AudioParameterBool>(
-        params.at(Names::BYPASS_HIGH),
-        params.at(Names::BYPASS_HIGH),
+        getParamId(Names::BYPASS_HIGH),
+        getParamId(Names::BYPASS_HIGH),
         false));
     layout.add(std::make_unique<AudioParameterBool>(
-        params.at(Names::MUTE_HIGH),
-        params.at(Names::MUTE_HIGH),
+        getParamId(Names::MUTE_HIGH),
+        getParamId(Names::MUTE_HIGH),
         false));
     layout.add(std::make_unique<AudioParameterBool>(
-        params.at(Names::SOLO_HIGH),
-        params.at(Names::SOLO_HIGH),
+        getParamId(Names::SOLO_HIGH),
+        getParamId(Names::SOLO_HIGH),
         false));
 
     return layout;
@@ -46,46 +46,66 @@ namespace params
         SOLO_LOW,
         SOLO_MID,
         SOLO_HIGH,
+
+        NUM_PARAMS
+    };
+
+    // Indexed by Names, so the order here must match the enum above.
+    inline constexpr std::array<const char*, NUM_PARAMS> paramIds =
+    {
+        "Low-Mid Crossover Frequency",
+        "Mid-High Crossover Frequency",
+        "Bypass Global",
+        "Attack Low Band",
+        "Attack Mid Band",
+        "Attack High Band",
+        "Release Low Band",
+        "Release Mid Band",
+        "Release High Band",
+        "Threshold Low Band",
+        "Threshold Mid Band",
+        "Threshold High Band",
+        "Ratio Low Band",
+        "Ratio Mid Band",
+        "Ratio High Band",
+        "Bypass Low Band",
+        "Bypass Mid Band",
+        "Bypass High Band",
+        "Mute Low Band",
+        "Mute Mid Band",
+        "Mute High Band",
+        "Solo Low Band",
+        "Solo Mid Band",
+        "Solo High Band",
     };
 
-    inline const std::map<Names, juce::String> getParams()
+    // Entries missing from the initialiser above are left as nullptr.
+    constexpr bool allParamIdsSet()
     {
-        static std::map<Names, juce::String> params =
+        for (auto id : paramIds)
         {
-            { LOW_MID_CROSSOVER_FREQ, "Low-Mid Crossover Frequency" },
-            { MID_HIGH_CROSSOVER_FREQ, "Mid-High Crossover Frequency" },
-            { BYPASS_GLOBAL, "Bypass Global" },
-            { ATTACK_LOW, "Attack Low Band" },
-            { ATTACK_MID, "Attack Mid Band" },
-            { ATTACK_HIGH, "Attack High Band" },
-            { RELEASE_LOW, "Release Low Band" },
-            { RELEASE_MID, "Release Mid Band" },
-            { RELEASE_HIGH, "Release High Band" },
-            { THRESHOLD_LOW, "Threshold Low Band" },
-            { THRESHOLD_MID, "Threshold Mid Band" },
-            { THRESHOLD_HIGH, "Threshold High Band" },
-            { RATIO_LOW, "Ratio Low Band" },
-            { RATIO_MID, "Ratio Mid Band" },
-            { RATIO_HIGH, "Ratio High Band" },
-            { BYPASS_LOW, "Bypass Low Band" },
-            { BYPASS_MID, "Bypass Mid Band" },
-            { BYPASS_HIGH, "Bypass High Band" },
-            { MUTE_LOW, "Mute Low Band" },
-            { MUTE_MID, "Mute Mid Band" },
-            { MUTE_HIGH, "Mute High Band" },
-            { SOLO_LOW, "Solo Low Band" },
-            { SOLO_MID, "Solo Mid Band" },
-            { SOLO_HIGH, "Solo High Band" },
-        };
-
-        return params;
+            if (id == nullptr || id[0] == '\0')
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    static_assert(allParamIdsSet(), "every params::Names entry needs an ID in paramIds");
+
+    constexpr const char* getParamId(Names name)
+    {
+        return paramIds[static_cast<size_t>(name)];
     }
 }
 
 //==============================================================================
 /**
 */
-class SimpleMBCompAudioProcessor  : public juce::AudioProcessor
+class SimpleMBCompAudioProcessor  : public juce::AudioProcessor,
+                                    private juce::AudioProcessorValueTreeState::Listener
 {
 public:
     //==============================================================================
@@ -128,9 +148,44 @@ public:
     using APVTS = juce::AudioProcessorValueTreeState;
     static APVTS::ParameterLayout createParameterLayout();
 
+private:
+    // Declared before apvts, so the tables createParameterLayout() reads stay
+    // alive for the compressor bands instead of being rebuilt.
+    juce::SharedResourcePointer<SharedResources> sharedResources;
+
+public:
     APVTS apvts { *this, nullptr, "Parameters", createParameterLayout() };
 
+protected:
+    // processBlock() is splitBands() followed by the specialised band stage.
+    // These let the reference band stage in Tests/ run on the same split.
+    void splitBands(const juce::AudioBuffer<float>& buffer);
+    std::array<CompressorBand, 3>& getCompressorBands() { return compressorBands; }
+    std::array<juce::AudioBuffer<float>, 3>& getFilterBuffers() { return filterBuffers; }
+    bool isGloballyBypassed() const { return globalBypass->get(); }
+
 private:
+    void parameterChanged(const juce::String& parameterID, float newValue) override;
+    void updateBandDispatch();
+
+    // Writes the sum of the bands selected by BandMask (bit i = filterBuffers[i])
+    // into buffer. Channel count and band selection are compile-time constants so
+    // the inner loop has no branches.
+    template <int NumChannels, int BandMask>
+    void sumBands(juce::AudioBuffer<float>& buffer);
+
+    using SumBandsFn = void (SimpleMBCompAudioProcessor::*)(juce::AudioBuffer<float>&);
+    using SumBandsTable = std::array<std::array<SumBandsFn, 8>, 2>;
+
+    template <int NumChannels, size_t... BandMasks>
+    static constexpr std::array<SumBandsFn, sizeof...(BandMasks)> makeSumBandsRow(std::index_sequence<BandMasks...>)
+    {
+        return { &SimpleMBCompAudioProcessor::sumBands<NumChannels, static_cast<int>(BandMasks)>... };
+    }
+
+    //      [numChannels - 1][band mask]
+    static const SumBandsTable sumBandsTable;
+
     std::array<CompressorBand, 3> compressorBands;
     CompressorBand& lowBandComp = compressorBands[0];
     CompressorBand& midBandComp = compressorBands[1];
@@ -149,6 +204,13 @@ private:
 
     std::array<juce::AudioBuffer<float>, 3> filterBuffers;
 
+    // Set from the parameter listener, picked up at the start of the next block.
+    std::atomic<bool> bandConfigChanged{ true };
+    int numProcessChannels{ 2 };
+    std::array<size_t, 3> activeBands{};
+    size_t numActiveBands{ 0 };
+    SumBandsFn sumActiveBands{ nullptr };
+
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SimpleMBCompAudioProcessor)
 };
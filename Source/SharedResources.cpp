@@ -0,0 +1,12 @@
+#include "SharedResources.h"
+
+SharedResources::SharedResources()
+{
+    auto ratioChoices = std::vector<double>{ 1, 1.5, 2, 3, 4, 5, 6, 8, 12, 16, 24, 32, 64, 128 };
+
+    for (auto choice : ratioChoices)
+    {
+        ratioChoiceNames.add(juce::String(choice, 1));
+        ratioValues.push_back(static_cast<float>(choice));
+    }
+}
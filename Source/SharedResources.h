@@ -0,0 +1,17 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+/*
+    Read-only data that is identical for every plugin instance in the process.
+    Hold it through juce::SharedResourcePointer<SharedResources>: the first
+    instance builds it (in its constructor, never on the audio thread) and it
+    is freed when the last instance goes away.
+*/
+struct SharedResources
+{
+    SharedResources();
+
+    juce::StringArray ratioChoiceNames;
+    std::vector<float> ratioValues;
+};
@@ -0,0 +1,723 @@
+/*
+  ==============================================================================
+
+    Headless stream host for SimpleMBComp.
+
+    Reads raw interleaved PCM from stdin or a FIFO, runs it through
+    SimpleMBCompAudioProcessor in fixed-size blocks and writes the result to
+    stdout or a FIFO. Reading, processing and writing run on separate threads
+    connected by double buffers, so I/O for one block overlaps processing of
+    the next.
+
+    Parameters can be changed live by writing lines of the form
+        <parameter id>=<value>
+    to the control FIFO, e.g. "Threshold Low Band=-24" or "Solo Mid Band=on".
+
+    The host stops at end of input or on SIGINT/SIGTERM, and prints a latency
+    report to stderr either way.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../../Source/PluginProcessor.h"
+
+#include <atomic>
+#include <cstring>
+#include <iostream>
+#include <thread>
+
+#include <csignal>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace
+{
+    enum class SampleFormat
+    {
+        float32,
+        int16,
+    };
+
+    struct Options
+    {
+        double sampleRate{ 48000.0 };
+        int numChannels{ 2 };
+        int blockSize{ 64 };
+        SampleFormat format{ SampleFormat::float32 };
+        juce::String inputPath{ "-" };
+        juce::String outputPath{ "-" };
+        juce::String controlPath;
+        int realtimePriority{ 0 };
+        bool lockMemory{ false };
+    };
+
+    void printUsage()
+    {
+        std::cerr << "Usage: SimpleMBCompStream [options]\n"
+                     "  --input=<path|->        raw PCM input, '-' for stdin (default)\n"
+                     "  --output=<path|->       raw PCM output, '-' for stdout (default)\n"
+                     "  --control=<fifo>        read '<parameter id>=<value>' lines from this FIFO\n"
+                     "  --sample-rate=<hz>      default 48000\n"
+                     "  --channels=<1|2>        default 2\n"
+                     "  --block=<frames>        default 64\n"
+                     "  --format=<f32|s16>      interleaved little-endian sample format, default f32\n"
+                     "  --realtime=<priority>   run the processing thread with SCHED_FIFO\n"
+                     "  --mlock                 lock all current and future pages in memory\n";
+    }
+
+    //==============================================================================
+    /** Fixed slots of interleaved samples handed from one producer thread to
+        one consumer thread. Each slot carries the time its input became
+        available so the writer can measure end-to-end latency.
+
+        The handoff is lock-free: slot ownership moves through atomic indices
+        and the threads only sleep in sem_wait, which is futex based and never
+        shares a lock with the other side. That keeps a SCHED_FIFO processing
+        thread from waiting on a mutex held by a normal-priority I/O thread.
+        close() only touches atomics and sem_post, so it is safe to call from
+        a signal handler.
+    */
+    class DoubleBuffer
+    {
+    public:
+        static constexpr size_t numSlots = 2;
+
+        DoubleBuffer(size_t samplesPerSlot)
+        {
+            for (auto& slot : slots)
+            {
+                slot.samples.resize(samplesPerSlot);
+            }
+
+            sem_init(&freeSlots, 0, static_cast<unsigned int>(numSlots));
+            sem_init(&filledSlots, 0, 0);
+        }
+
+        ~DoubleBuffer()
+        {
+            sem_destroy(&freeSlots);
+            sem_destroy(&filledSlots);
+        }
+
+        struct Slot
+        {
+            std::vector<float> samples;
+            size_t numFrames{ 0 };
+            juce::int64 inputTicks{ 0 };
+        };
+
+        /** Blocks until a slot is free. Returns nullptr once the buffer is closed. */
+        Slot* beginWrite()
+        {
+            waitFor(freeSlots);
+
+            if (closed)
+            {
+                // Keep the wake-up for the next caller.
+                sem_post(&freeSlots);
+                return nullptr;
+            }
+
+            return &slots[writeIndex];
+        }
+
+        void endWrite()
+        {
+            writeIndex = (writeIndex + 1) % numSlots;
+            numFilled.fetch_add(1, std::memory_order_release);
+            sem_post(&filledSlots);
+        }
+
+        /** Blocks until a slot is filled. Returns nullptr once the buffer is closed and drained. */
+        Slot* beginRead()
+        {
+            waitFor(filledSlots);
+
+            if (numFilled.load(std::memory_order_acquire) == 0)
+            {
+                // Only close() posts without filling a slot.
+                jassert(closed);
+                sem_post(&filledSlots);
+                return nullptr;
+            }
+
+            return &slots[readIndex];
+        }
+
+        void endRead()
+        {
+            readIndex = (readIndex + 1) % numSlots;
+            numFilled.fetch_sub(1, std::memory_order_release);
+            sem_post(&freeSlots);
+        }
+
+        void close()
+        {
+            closed = true;
+            sem_post(&freeSlots);
+            sem_post(&filledSlots);
+        }
+
+    private:
+        static void waitFor(sem_t& semaphore)
+        {
+            while (sem_wait(&semaphore) != 0 && errno == EINTR)
+            {
+            }
+        }
+
+        std::array<Slot, numSlots> slots;
+
+        // Each index is only touched by its own side.
+        size_t writeIndex{ 0 };
+        size_t readIndex{ 0 };
+
+        std::atomic<size_t> numFilled{ 0 };
+        std::atomic<bool> closed{ false };
+        sem_t freeSlots;
+        sem_t filledSlots;
+
+        JUCE_DECLARE_NON_COPYABLE(DoubleBuffer)
+    };
+
+    //==============================================================================
+    // stopRequested is only set by SIGINT/SIGTERM and makes the writer give up
+    // on whatever is still queued. stopReading releases the reader and the
+    // control thread; the signal handler sets it too, and at end of input it
+    // is set once the writer has drained. The handler also closes the buffers
+    // so every thread wakes up and the latency report still gets printed.
+    std::atomic<bool> stopRequested{ false };
+    std::atomic<bool> stopReading{ false };
+    std::array<std::atomic<DoubleBuffer*>, 2> buffersToClose{};
+
+    void handleStopSignal(int)
+    {
+        stopRequested = true;
+        stopReading = true;
+
+        for (auto& buffer : buffersToClose)
+        {
+            if (auto* b = buffer.load())
+            {
+                b->close();
+            }
+        }
+    }
+
+    void installStopHandlers()
+    {
+        struct sigaction action{};
+        action.sa_handler = handleStopSignal;
+        sigemptyset(&action.sa_mask);
+
+        sigaction(SIGINT, &action, nullptr);
+        sigaction(SIGTERM, &action, nullptr);
+    }
+
+    //==============================================================================
+    struct LatencyStats
+    {
+        void add(double ms)
+        {
+            minMs = juce::jmin(minMs, ms);
+            maxMs = juce::jmax(maxMs, ms);
+            totalMs += ms;
+            count++;
+        }
+
+        juce::String toString() const
+        {
+            if (count == 0)
+            {
+                return "n/a";
+            }
+
+            return "min " + juce::String(minMs, 3) + " ms, avg " + juce::String(totalMs / count, 3)
+                 + " ms, max " + juce::String(maxMs, 3) + " ms";
+        }
+
+        double minMs{ std::numeric_limits<double>::max() };
+        double maxMs{ 0.0 };
+        double totalMs{ 0.0 };
+        juce::int64 count{ 0 };
+    };
+
+    double ticksToMs(juce::int64 ticks)
+    {
+        return juce::Time::highResolutionTicksToSeconds(ticks) * 1000.0;
+    }
+
+    //==============================================================================
+    size_t bytesPerSample(SampleFormat format)
+    {
+        return format == SampleFormat::float32 ? sizeof(float) : sizeof(int16_t);
+    }
+
+    /** Reads until numBytes arrived, the stream ended or shouldStop was set.
+        Returns the byte count read.
+    */
+    size_t readFully(int fd, char* dest, size_t numBytes, const std::atomic<bool>& shouldStop)
+    {
+        size_t total = 0;
+
+        while (total < numBytes && !shouldStop)
+        {
+            pollfd pfd{ fd, POLLIN, 0 };
+            auto numReady = ::poll(&pfd, 1, 100);
+
+            // Timeouts and EINTR go back round to the shouldStop check.
+            if (numReady == 0 || (numReady < 0 && errno == EINTR))
+            {
+                continue;
+            }
+
+            if (numReady < 0)
+            {
+                break;
+            }
+
+            auto result = ::read(fd, dest + total, numBytes - total);
+
+            if (result < 0 && errno == EINTR)
+            {
+                continue;
+            }
+
+            if (result <= 0)
+            {
+                break;
+            }
+
+            total += static_cast<size_t>(result);
+        }
+
+        return total;
+    }
+
+    /** Writes all of numBytes. Returns false if the output closed or shouldStop was set. */
+    bool writeFully(int fd, const char* source, size_t numBytes, const std::atomic<bool>& shouldStop)
+    {
+        size_t total = 0;
+
+        while (total < numBytes)
+        {
+            if (shouldStop)
+            {
+                return false;
+            }
+
+            pollfd pfd{ fd, POLLOUT, 0 };
+            auto numReady = ::poll(&pfd, 1, 100);
+
+            if (numReady == 0 || (numReady < 0 && errno == EINTR))
+            {
+                continue;
+            }
+
+            if (numReady < 0)
+            {
+                return false;
+            }
+
+            auto result = ::write(fd, source + total, numBytes - total);
+
+            if (result < 0 && errno == EINTR)
+            {
+                continue;
+            }
+
+            if (result <= 0)
+            {
+                return false;
+            }
+
+            total += static_cast<size_t>(result);
+        }
+
+        return true;
+    }
+
+    void readerLoop(int fd, const Options& options, DoubleBuffer& input, const std::atomic<bool>& shouldStop)
+    {
+        auto frameBytes = bytesPerSample(options.format) * static_cast<size_t>(options.numChannels);
+        std::vector<char> raw(frameBytes * static_cast<size_t>(options.blockSize));
+
+        while (auto* slot = input.beginWrite())
+        {
+            auto numBytes = readFully(fd, raw.data(), raw.size(), shouldStop);
+            slot->numFrames = numBytes / frameBytes;
+            slot->inputTicks = juce::Time::getHighResolutionTicks();
+
+            auto numSamples = slot->numFrames * static_cast<size_t>(options.numChannels);
+
+            if (options.format == SampleFormat::float32)
+            {
+                std::memcpy(slot->samples.data(), raw.data(), numSamples * sizeof(float));
+            }
+            else
+            {
+                auto* source = reinterpret_cast<const int16_t*>(raw.data());
+                for (size_t i = 0; i < numSamples; i++)
+                {
+                    slot->samples[i] = static_cast<float>(source[i]) / 32768.0f;
+                }
+            }
+
+            if (slot->numFrames == 0)
+            {
+                break;
+            }
+
+            input.endWrite();
+
+            if (numBytes < raw.size())
+            {
+                break;
+            }
+        }
+
+        input.close();
+    }
+
+    void writerLoop(int fd, const Options& options, DoubleBuffer& output, LatencyStats& endToEnd,
+                    const std::atomic<bool>& shouldStop)
+    {
+        std::vector<char> raw(bytesPerSample(options.format)
+                              * static_cast<size_t>(options.numChannels * options.blockSize));
+
+        while (auto* slot = output.beginRead())
+        {
+            auto numSamples = slot->numFrames * static_cast<size_t>(options.numChannels);
+
+            if (options.format == SampleFormat::float32)
+            {
+                std::memcpy(raw.data(), slot->samples.data(), numSamples * sizeof(float));
+            }
+            else
+            {
+                auto* dest = reinterpret_cast<int16_t*>(raw.data());
+                for (size_t i = 0; i < numSamples; i++)
+                {
+                    auto sample = juce::jlimit(-1.0f, 1.0f, slot->samples[i]);
+                    dest[i] = static_cast<int16_t>(juce::roundToInt(sample * 32767.0f));
+                }
+            }
+
+            auto inputTicks = slot->inputTicks;
+            auto ok = writeFully(fd, raw.data(), numSamples * bytesPerSample(options.format), shouldStop);
+            output.endRead();
+
+            if (!ok)
+            {
+                if (!shouldStop)
+                {
+                    std::cerr << "Output closed, stopping.\n";
+                }
+                break;
+            }
+
+            endToEnd.add(ticksToMs(juce::Time::getHighResolutionTicks() - inputTicks));
+        }
+
+        output.close();
+    }
+
+    //==============================================================================
+    void applyControlLine(SimpleMBCompAudioProcessor& processor, const juce::String& line)
+    {
+        auto id = line.upToFirstOccurrenceOf("=", false, false).trim();
+        auto value = line.fromFirstOccurrenceOf("=", false, false).trim();
+
+        if (id.isEmpty() || value.isEmpty())
+        {
+            return;
+        }
+
+        auto* param = processor.apvts.getParameter(id);
+
+        if (param == nullptr)
+        {
+            std::cerr << "Unknown parameter: " << id << "\n";
+            return;
+        }
+
+        param->setValueNotifyingHost(param->getValueForText(value));
+    }
+
+    void controlLoop(const juce::String& path, SimpleMBCompAudioProcessor& processor, const std::atomic<bool>& shouldStop)
+    {
+        while (!shouldStop)
+        {
+            // O_NONBLOCK lets the open succeed before a writer appears, so the
+            // loop can still notice shouldStop.
+            auto fd = ::open(path.toRawUTF8(), O_RDONLY | O_NONBLOCK);
+
+            if (fd < 0)
+            {
+                std::cerr << "Could not open control FIFO: " << path << "\n";
+                return;
+            }
+
+            juce::String pending;
+            bool writerSeen = false;
+
+            while (!shouldStop)
+            {
+                pollfd pfd{ fd, POLLIN, 0 };
+                auto numReady = ::poll(&pfd, 1, 100);
+
+                if (numReady == 0 || (numReady < 0 && errno == EINTR))
+                {
+                    continue;
+                }
+
+                if (numReady < 0)
+                {
+                    break;
+                }
+
+                char chunk[256];
+                auto numBytes = ::read(fd, chunk, sizeof(chunk));
+
+                if (numBytes > 0)
+                {
+                    writerSeen = true;
+                    pending += juce::String::fromUTF8(chunk, static_cast<int>(numBytes));
+
+                    while (pending.containsChar('\n'))
+                    {
+                        applyControlLine(processor, pending.upToFirstOccurrenceOf("\n", false, false));
+                        pending = pending.fromFirstOccurrenceOf("\n", false, false);
+                    }
+                }
+                else if (numBytes == 0)
+                {
+                    // Writer went away. Reopen so the next writer is picked up.
+                    if (writerSeen)
+                    {
+                        break;
+                    }
+
+                    juce::Thread::sleep(100);
+                }
+            }
+
+            ::close(fd);
+        }
+    }
+
+    //==============================================================================
+    void setRealtimePriority(int priority)
+    {
+        sched_param param{};
+        param.sched_priority = priority;
+
+        if (pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) != 0)
+        {
+            std::cerr << "Could not set SCHED_FIFO priority " << priority
+                      << " (needs CAP_SYS_NICE or an rtprio limit), continuing without it.\n";
+        }
+    }
+
+    bool parseOptions(const juce::ArgumentList& args, Options& options)
+    {
+        if (args.containsOption("--help|-h"))
+        {
+            return false;
+        }
+
+        if (args.containsOption("--input"))
+            options.inputPath = args.getValueForOption("--input");
+        if (args.containsOption("--output"))
+            options.outputPath = args.getValueForOption("--output");
+        if (args.containsOption("--control"))
+            options.controlPath = args.getValueForOption("--control");
+        if (args.containsOption("--sample-rate"))
+            options.sampleRate = args.getValueForOption("--sample-rate").getDoubleValue();
+        if (args.containsOption("--channels"))
+            options.numChannels = args.getValueForOption("--channels").getIntValue();
+        if (args.containsOption("--block"))
+            options.blockSize = args.getValueForOption("--block").getIntValue();
+        if (args.containsOption("--realtime"))
+            options.realtimePriority = args.getValueForOption("--realtime").getIntValue();
+
+        options.lockMemory = args.containsOption("--mlock");
+
+        if (args.containsOption("--format"))
+        {
+            auto format = args.getValueForOption("--format");
+
+            if (format == "f32")
+                options.format = SampleFormat::float32;
+            else if (format == "s16")
+                options.format = SampleFormat::int16;
+            else
+                return false;
+        }
+
+        return options.sampleRate > 0
+            && (options.numChannels == 1 || options.numChannels == 2)
+            && options.blockSize > 0;
+    }
+}
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+    juce::ArgumentList args(argc, argv);
+    Options options;
+
+    if (!parseOptions(args, options))
+    {
+        printUsage();
+        return 1;
+    }
+
+    std::signal(SIGPIPE, SIG_IGN);
+
+    if (options.lockMemory && mlockall(MCL_CURRENT | MCL_FUTURE) != 0)
+    {
+        std::cerr << "mlockall failed, continuing with unlocked memory.\n";
+    }
+
+    auto inputFd = options.inputPath == "-" ? STDIN_FILENO : ::open(options.inputPath.toRawUTF8(), O_RDONLY);
+    auto outputFd = options.outputPath == "-" ? STDOUT_FILENO
+                                              : ::open(options.outputPath.toRawUTF8(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+
+    if (inputFd < 0 || outputFd < 0)
+    {
+        std::cerr << "Could not open input or output.\n";
+        return 1;
+    }
+
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+    SimpleMBCompAudioProcessor processor;
+
+    auto channelSet = options.numChannels == 1 ? juce::AudioChannelSet::mono() : juce::AudioChannelSet::stereo();
+    juce::AudioProcessor::BusesLayout layout;
+    layout.inputBuses.add(channelSet);
+    layout.outputBuses.add(channelSet);
+
+    if (!processor.setBusesLayout(layout))
+    {
+        std::cerr << "Unsupported channel layout.\n";
+        return 1;
+    }
+
+    processor.setRateAndBufferSizeDetails(options.sampleRate, options.blockSize);
+    processor.prepareToPlay(options.sampleRate, options.blockSize);
+
+    auto samplesPerSlot = static_cast<size_t>(options.numChannels * options.blockSize);
+    DoubleBuffer input(samplesPerSlot);
+    DoubleBuffer output(samplesPerSlot);
+    LatencyStats processing;
+    LatencyStats endToEnd;
+
+    buffersToClose[0] = &input;
+    buffersToClose[1] = &output;
+    installStopHandlers();
+
+    std::thread reader(readerLoop, inputFd, std::cref(options), std::ref(input), std::cref(stopReading));
+    std::thread writer(writerLoop, outputFd, std::cref(options), std::ref(output), std::ref(endToEnd), std::cref(stopRequested));
+    std::thread control;
+
+    if (options.controlPath.isNotEmpty())
+    {
+        control = std::thread(controlLoop, options.controlPath, std::ref(processor), std::cref(stopReading));
+    }
+
+    if (options.realtimePriority > 0)
+    {
+        setRealtimePriority(options.realtimePriority);
+    }
+
+    juce::AudioBuffer<float> buffer(options.numChannels, options.blockSize);
+    juce::MidiBuffer midi;
+
+    while (auto* in = input.beginRead())
+    {
+        auto* out = output.beginWrite();
+
+        if (out == nullptr)
+        {
+            input.endRead();
+            break;
+        }
+
+        auto start = juce::Time::getHighResolutionTicks();
+        auto numFrames = static_cast<int>(in->numFrames);
+        buffer.setSize(options.numChannels, numFrames, false, false, true);
+
+        for (int ch = 0; ch < options.numChannels; ch++)
+        {
+            auto* dest = buffer.getWritePointer(ch);
+            for (int i = 0; i < numFrames; i++)
+            {
+                dest[i] = in->samples[static_cast<size_t>(i * options.numChannels + ch)];
+            }
+        }
+
+        processor.processBlock(buffer, midi);
+
+        for (int ch = 0; ch < options.numChannels; ch++)
+        {
+            auto* source = buffer.getReadPointer(ch);
+            for (int i = 0; i < numFrames; i++)
+            {
+                out->samples[static_cast<size_t>(i * options.numChannels + ch)] = source[i];
+            }
+        }
+
+        out->numFrames = in->numFrames;
+        out->inputTicks = in->inputTicks;
+
+        input.endRead();
+        output.endWrite();
+
+        processing.add(ticksToMs(juce::Time::getHighResolutionTicks() - start));
+    }
+
+    // At end of input this lets the writer flush every queued block before
+    // anything tells it to give up. After a signal it has already given up.
+    output.close();
+    writer.join();
+
+    stopReading = true;
+    input.close();
+    reader.join();
+
+    if (control.joinable())
+    {
+        control.join();
+    }
+
+    buffersToClose[0] = nullptr;
+    buffersToClose[1] = nullptr;
+
+    processor.releaseResources();
+
+    // Every block in flight owns a slot in the input or the output buffer:
+    // the one the reader fills, the one being processed (which also holds an
+    // output slot), those queued and the one being written.
+    auto maxBlocksInFlight = 2 * DoubleBuffer::numSlots;
+    auto blockMs = 1000.0 * options.blockSize / options.sampleRate;
+    auto bufferedMs = blockMs * static_cast<double>(maxBlocksInFlight);
+
+    std::cerr << "Latency report\n"
+              << "  block: " << options.blockSize << " frames (" << juce::String(blockMs, 3) << " ms)\n"
+              << "  plugin latency: " << processor.getLatencySamples() << " samples\n"
+              << "  worst-case pipeline buffering: " << juce::String(bufferedMs, 3) << " ms ("
+              << maxBlocksInFlight << " blocks in flight)\n"
+              << "  processing per block: " << processing.toString() << "\n"
+              << "  input available -> output written: " << endToEnd.toString() << "\n"
+              << "  measured end-to-end estimate (block fill + avg above): "
+              << juce::String(blockMs + (endToEnd.count > 0 ? endToEnd.totalMs / endToEnd.count : 0.0), 3)
+              << " ms\n";
+
+    return 0;
+}
@@ -0,0 +1,80 @@
+/*
+  ==============================================================================
+
+    Session-recall benchmark: constructs instances, restores a saved state and
+    prepares them, the way a host does when it opens a large session.
+
+    Report only. The timings are logged, but no budget is enforced until one
+    has been set from recorded runs; the only expectations are that every
+    instance restores the saved state.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../../Source/PluginProcessor.h"
+
+class LoadBenchmarkTests : public juce::UnitTest
+{
+public:
+    LoadBenchmarkTests() : juce::UnitTest("Session load benchmark", "SimpleMBComp") {}
+
+    void runTest() override
+    {
+        using namespace params;
+
+        constexpr int numInstances = 100;
+        constexpr double sampleRate = 48000.0;
+        constexpr int blockSize = 512;
+
+        beginTest("Load " + juce::String(numInstances) + " instances");
+
+        juce::MemoryBlock state;
+        float savedThreshold = 0.0f;
+
+        {
+            SimpleMBCompAudioProcessor reference;
+            auto* threshold = reference.apvts.getParameter(getParamId(THRESHOLD_LOW));
+            threshold->setValueNotifyingHost(0.25f);
+            reference.apvts.getParameter(getParamId(RATIO_MID))->setValueNotifyingHost(0.5f);
+            savedThreshold = threshold->getValue();
+            reference.getStateInformation(state);
+        }
+
+        std::vector<std::unique_ptr<SimpleMBCompAudioProcessor>> instances;
+        instances.reserve(numInstances);
+
+        double minMs = std::numeric_limits<double>::max();
+        double maxMs = 0.0;
+        auto start = juce::Time::getHighResolutionTicks();
+
+        for (int i = 0; i < numInstances; i++)
+        {
+            auto instanceStart = juce::Time::getHighResolutionTicks();
+
+            auto instance = std::make_unique<SimpleMBCompAudioProcessor>();
+            instance->setStateInformation(state.getData(), static_cast<int>(state.getSize()));
+            instance->setRateAndBufferSizeDetails(sampleRate, blockSize);
+            instance->prepareToPlay(sampleRate, blockSize);
+            instances.push_back(std::move(instance));
+
+            auto ms = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - instanceStart) * 1000.0;
+            minMs = juce::jmin(minMs, ms);
+            maxMs = juce::jmax(maxMs, ms);
+        }
+
+        auto totalMs = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start) * 1000.0;
+
+        logMessage("Per instance: min " + juce::String(minMs, 3) + " ms, avg "
+                   + juce::String(totalMs / numInstances, 3) + " ms, max " + juce::String(maxMs, 3) + " ms");
+        logMessage("Total: " + juce::String(totalMs, 3) + " ms");
+
+        for (const auto& instance : instances)
+        {
+            expectWithinAbsoluteError(instance->apvts.getParameter(getParamId(THRESHOLD_LOW))->getValue(),
+                                      savedThreshold, 1.0e-6f);
+        }
+    }
+};
+
+static LoadBenchmarkTests loadBenchmarkTests;
@@ -0,0 +1,27 @@
+/*
+  ==============================================================================
+
+    Runs every juce::UnitTest in the SimpleMBComp category and exits non-zero
+    if any expectation failed.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+
+int main()
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    juce::UnitTestRunner runner;
+    runner.setAssertOnFailure(false);
+    runner.runTestsInCategory("SimpleMBComp");
+
+    int numFailures = 0;
+    for (int i = 0; i < runner.getNumResults(); i++)
+    {
+        numFailures += runner.getResult(i)->failures;
+    }
+
+    return numFailures > 0 ? 1 : 0;
+}
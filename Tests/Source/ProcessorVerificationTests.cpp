@@ -0,0 +1,544 @@
+/*
+  ==============================================================================
+
+    Golden-output checks for the optimised processing paths.
+
+    Renders fixed stimuli (sine sweep, pink noise, impulse, transient bursts)
+    through SimpleMBCompAudioProcessor and through ReferenceProcessor, whose
+    band stage is the plain per-block implementation, and compares per-sample
+    error and gain-reduction trajectories. Band states are also toggled
+    between blocks and the channel count is changed on a live instance, so
+    the listener-driven re-dispatch is exercised.
+
+    Both paths share the crossover (splitBands()), so the per-sample
+    comparison only covers band selection, compression and summing. The
+    crossover itself is covered only by the flatness test, which checks that
+    low + mid + high sums to an allpass.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../../Source/PluginProcessor.h"
+
+//==============================================================================
+/** The band stage as it was before the specialised kernels: mute, bypass and
+    solo are read on every block and bands are summed with addFrom.
+*/
+class ReferenceProcessor : public SimpleMBCompAudioProcessor
+{
+public:
+    void processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer&) override
+    {
+        juce::ScopedNoDenormals noDenormals;
+
+        auto& filterBuffers = getFilterBuffers();
+        auto& compressorBands = getCompressorBands();
+
+        splitBands(buffer);
+
+        buffer.clear();
+
+        auto numSamples = buffer.getNumSamples();
+        auto numChannels = buffer.getNumChannels();
+
+        auto addToBuffer = [ns = numSamples, nc = numChannels](juce::AudioBuffer<float>& dest, const auto& source)
+        {
+            for (int i = 0; i < nc; i++)
+            {
+                dest.addFrom(i, 0, source, i, 0, ns);
+            }
+        };
+
+        if (isGloballyBypassed())
+        {
+            for (size_t i = 0; i < filterBuffers.size(); i++)
+            {
+                addToBuffer(buffer, filterBuffers[i]);
+            }
+            return;
+        }
+
+        bool isSoloed = false;
+        for (size_t i = 0; i < compressorBands.size(); i++)
+        {
+            auto& band = compressorBands[i];
+            band.updateCompressorSettings();
+
+            if (band.mute->get())
+            {
+                filterBuffers[i].clear();
+            }
+            else if (!band.bypass->get())
+            {
+                band.process(filterBuffers[i]);
+            }
+
+            isSoloed |= band.solo->get();
+        }
+
+        for (size_t i = 0; i < filterBuffers.size(); i++)
+        {
+            if (isSoloed && !compressorBands[i].solo->get())
+            {
+                continue;
+            }
+
+            addToBuffer(buffer, filterBuffers[i]);
+        }
+    }
+};
+
+//==============================================================================
+namespace
+{
+    // The specialised kernels add the same bands in the same order as the
+    // reference path, so anything above rounding noise is a real difference.
+    constexpr float maxSampleError = 1.0e-6f;
+    constexpr float maxGainReductionErrorDb = 0.01f;
+    constexpr float maxCrossoverDeviationDb = 0.1f;
+
+    constexpr double sampleRate = 48000.0;
+    constexpr int blockSize = 64;
+    constexpr int stimulusLength = 1 << 15;
+    constexpr int gainWindow = 64;
+
+    struct Stimulus
+    {
+        juce::String name;
+        juce::AudioBuffer<float> buffer;
+    };
+
+    /** Values are in parameter units; for choice parameters that is the choice index. */
+    struct ParameterChange
+    {
+        int block;
+        params::Names name;
+        float value;
+    };
+
+    struct BandConfig
+    {
+        juce::String name;
+        std::vector<ParameterChange> changes;
+    };
+
+    //==============================================================================
+    juce::AudioBuffer<float> makeSineSweep(int numChannels)
+    {
+        juce::AudioBuffer<float> buffer(numChannels, stimulusLength);
+        auto startHz = 20.0;
+        auto endHz = 20000.0;
+        auto duration = stimulusLength / sampleRate;
+        auto k = std::log(endHz / startHz);
+        auto phaseScale = juce::MathConstants<double>::twoPi * startHz * duration / k;
+
+        for (int i = 0; i < stimulusLength; i++)
+        {
+            auto t = i / sampleRate;
+            auto sample = static_cast<float>(0.5 * std::sin(phaseScale * (std::exp(k * t / duration) - 1.0)));
+
+            for (int ch = 0; ch < numChannels; ch++)
+            {
+                buffer.setSample(ch, i, sample);
+            }
+        }
+
+        return buffer;
+    }
+
+    juce::AudioBuffer<float> makePinkNoise(int numChannels)
+    {
+        juce::AudioBuffer<float> buffer(numChannels, stimulusLength);
+        juce::Random random(0x5eed);
+
+        for (int ch = 0; ch < numChannels; ch++)
+        {
+            // Paul Kellet's economy pink filter.
+            float b0 = 0, b1 = 0, b2 = 0;
+
+            for (int i = 0; i < stimulusLength; i++)
+            {
+                auto white = random.nextFloat() * 2.0f - 1.0f;
+                b0 = 0.99765f * b0 + white * 0.0990460f;
+                b1 = 0.96300f * b1 + white * 0.2965164f;
+                b2 = 0.57000f * b2 + white * 1.0526913f;
+                buffer.setSample(ch, i, 0.1f * (b0 + b1 + b2 + white * 0.1848f));
+            }
+        }
+
+        return buffer;
+    }
+
+    juce::AudioBuffer<float> makeImpulse(int numChannels, float amplitude)
+    {
+        juce::AudioBuffer<float> buffer(numChannels, stimulusLength);
+        buffer.clear();
+
+        for (int ch = 0; ch < numChannels; ch++)
+        {
+            buffer.setSample(ch, 0, amplitude);
+        }
+
+        return buffer;
+    }
+
+    juce::AudioBuffer<float> makeTransientBursts(int numChannels)
+    {
+        juce::AudioBuffer<float> buffer(numChannels, stimulusLength);
+        buffer.clear();
+
+        auto burstLength = static_cast<int>(0.02 * sampleRate);
+        auto period = static_cast<int>(0.15 * sampleRate);
+
+        for (int start = 0; start + burstLength < stimulusLength; start += period)
+        {
+            for (int i = 0; i < burstLength; i++)
+            {
+                auto envelope = std::exp(-5.0f * i / burstLength);
+                auto sample = envelope * static_cast<float>(std::sin(juce::MathConstants<double>::twoPi * 1000.0 * i / sampleRate));
+
+                for (int ch = 0; ch < numChannels; ch++)
+                {
+                    buffer.setSample(ch, start + i, sample);
+                }
+            }
+        }
+
+        return buffer;
+    }
+
+    std::vector<Stimulus> makeStimuli(int numChannels)
+    {
+        std::vector<Stimulus> stimuli;
+        stimuli.push_back({ "sine sweep", makeSineSweep(numChannels) });
+        stimuli.push_back({ "pink noise", makePinkNoise(numChannels) });
+        stimuli.push_back({ "impulse", makeImpulse(numChannels, 1.0f) });
+        stimuli.push_back({ "transient bursts", makeTransientBursts(numChannels) });
+        return stimuli;
+    }
+
+    //==============================================================================
+    void setParameter(SimpleMBCompAudioProcessor& processor, params::Names name, float value)
+    {
+        auto* param = processor.apvts.getParameter(params::getParamId(name));
+        param->setValueNotifyingHost(param->convertTo0to1(value));
+    }
+
+    void prepare(SimpleMBCompAudioProcessor& processor, int numChannels)
+    {
+        juce::AudioProcessor::BusesLayout layout;
+        auto channelSet = numChannels == 1 ? juce::AudioChannelSet::mono() : juce::AudioChannelSet::stereo();
+        layout.inputBuses.add(channelSet);
+        layout.outputBuses.add(channelSet);
+
+        processor.releaseResources();
+        processor.setBusesLayout(layout);
+        processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+        processor.prepareToPlay(sampleRate, blockSize);
+    }
+
+    /** Processes input block by block, applying each change right before its
+        block. Changes at block 0 land before the first block is processed.
+    */
+    juce::AudioBuffer<float> render(SimpleMBCompAudioProcessor& processor, const juce::AudioBuffer<float>& input,
+                                    const std::vector<ParameterChange>& changes)
+    {
+        auto numChannels = input.getNumChannels();
+        auto numSamples = input.getNumSamples();
+
+        juce::AudioBuffer<float> output(input);
+        juce::AudioBuffer<float> block(numChannels, blockSize);
+        juce::MidiBuffer midi;
+
+        for (int start = 0, blockIndex = 0; start < numSamples; start += blockSize, blockIndex++)
+        {
+            for (const auto& change : changes)
+            {
+                if (change.block == blockIndex)
+                {
+                    setParameter(processor, change.name, change.value);
+                }
+            }
+
+            auto blockLength = juce::jmin(blockSize, numSamples - start);
+            block.setSize(numChannels, blockLength, false, false, true);
+
+            for (int ch = 0; ch < numChannels; ch++)
+            {
+                block.copyFrom(ch, 0, output, ch, start, blockLength);
+            }
+
+            processor.processBlock(block, midi);
+
+            for (int ch = 0; ch < numChannels; ch++)
+            {
+                output.copyFrom(ch, start, block, ch, 0, blockLength);
+            }
+        }
+
+        return output;
+    }
+
+    juce::AudioBuffer<float> renderFresh(const juce::AudioBuffer<float>& input, const std::vector<ParameterChange>& changes,
+                                         bool useReferencePath)
+    {
+        std::unique_ptr<SimpleMBCompAudioProcessor> processor;
+        if (useReferencePath)
+            processor = std::make_unique<ReferenceProcessor>();
+        else
+            processor = std::make_unique<SimpleMBCompAudioProcessor>();
+        prepare(*processor, input.getNumChannels());
+        return render(*processor, input, changes);
+    }
+
+    //==============================================================================
+    float maxAbsDifference(const juce::AudioBuffer<float>& a, const juce::AudioBuffer<float>& b)
+    {
+        float maxError = 0.0f;
+
+        for (int ch = 0; ch < a.getNumChannels(); ch++)
+        {
+            for (int i = 0; i < a.getNumSamples(); i++)
+            {
+                maxError = juce::jmax(maxError, std::abs(a.getSample(ch, i) - b.getSample(ch, i)));
+            }
+        }
+
+        return maxError;
+    }
+
+    /** Worst difference in output/input level, per gainWindow samples, between two renders. */
+    float maxGainReductionDifferenceDb(const juce::AudioBuffer<float>& input,
+                                       const juce::AudioBuffer<float>& a,
+                                       const juce::AudioBuffer<float>& b)
+    {
+        float maxError = 0.0f;
+
+        for (int ch = 0; ch < input.getNumChannels(); ch++)
+        {
+            for (int start = 0; start + gainWindow <= input.getNumSamples(); start += gainWindow)
+            {
+                auto inputRms = input.getRMSLevel(ch, start, gainWindow);
+
+                if (inputRms < 1.0e-4f)
+                {
+                    continue;
+                }
+
+                auto gainA = juce::Decibels::gainToDecibels(a.getRMSLevel(ch, start, gainWindow) / inputRms);
+                auto gainB = juce::Decibels::gainToDecibels(b.getRMSLevel(ch, start, gainWindow) / inputRms);
+                maxError = juce::jmax(maxError, std::abs(gainA - gainB));
+            }
+        }
+
+        return maxError;
+    }
+
+    /** Worst deviation from 0 dB of the impulse response magnitude between 20 Hz and 20 kHz. */
+    float maxMagnitudeDeviationDb(const juce::AudioBuffer<float>& impulseResponse, float impulseAmplitude)
+    {
+        constexpr int fftOrder = 15;
+        constexpr int fftSize = 1 << fftOrder;
+        static_assert(fftSize <= stimulusLength, "impulse response must cover the FFT");
+
+        juce::dsp::FFT fft(fftOrder);
+        std::vector<float> data(2 * fftSize, 0.0f);
+        float maxDeviation = 0.0f;
+
+        for (int ch = 0; ch < impulseResponse.getNumChannels(); ch++)
+        {
+            std::fill(data.begin(), data.end(), 0.0f);
+            std::copy_n(impulseResponse.getReadPointer(ch), fftSize, data.begin());
+            fft.performFrequencyOnlyForwardTransform(data.data());
+
+            auto firstBin = static_cast<int>(std::ceil(20.0 * fftSize / sampleRate));
+            auto lastBin = juce::jmin(fftSize / 2, static_cast<int>(20000.0 * fftSize / sampleRate));
+
+            for (int bin = firstBin; bin <= lastBin; bin++)
+            {
+                auto magnitudeDb = juce::Decibels::gainToDecibels(data[static_cast<size_t>(bin)] / impulseAmplitude, -200.0f);
+                maxDeviation = juce::jmax(maxDeviation, std::abs(magnitudeDb));
+            }
+        }
+
+        return maxDeviation;
+    }
+}
+
+//==============================================================================
+class ProcessorVerificationTests : public juce::UnitTest
+{
+public:
+    ProcessorVerificationTests() : juce::UnitTest("Processor verification", "SimpleMBComp") {}
+
+    void runTest() override
+    {
+        for (auto numChannels : { 1, 2 })
+        {
+            auto stimuli = makeStimuli(numChannels);
+
+            beginTest(juce::String(numChannels) + "ch static band configurations");
+            testStaticConfigurations(stimuli);
+
+            beginTest(juce::String(numChannels) + "ch band states toggled between blocks");
+            testToggledConfigurations(stimuli);
+
+            beginTest(juce::String(numChannels) + "ch crossover flatness");
+            testCrossoverFlatness(numChannels);
+        }
+
+        beginTest("Channel count changed on a live instance");
+        testChannelCountChanges();
+    }
+
+private:
+    void expectMatchesReference(const juce::String& context, const juce::AudioBuffer<float>& input,
+                                const juce::AudioBuffer<float>& reference, const juce::AudioBuffer<float>& optimised)
+    {
+        auto sampleError = maxAbsDifference(reference, optimised);
+        expect(sampleError <= maxSampleError,
+               context + ": sample error " + juce::String(sampleError) + " exceeds " + juce::String(maxSampleError));
+
+        auto gainError = maxGainReductionDifferenceDb(input, reference, optimised);
+        expect(gainError <= maxGainReductionErrorDb,
+               context + ": gain reduction error " + juce::String(gainError) + " dB exceeds "
+               + juce::String(maxGainReductionErrorDb) + " dB");
+    }
+
+    void testStaticConfigurations(const std::vector<Stimulus>& stimuli)
+    {
+        using namespace params;
+
+        const std::vector<BandConfig> configs =
+        {
+            { "default", {} },
+            { "heavy compression", { { 0, THRESHOLD_LOW, -36 }, { 0, THRESHOLD_MID, -36 }, { 0, THRESHOLD_HIGH, -36 },
+                                     { 0, RATIO_LOW, 7 }, { 0, RATIO_MID, 7 }, { 0, RATIO_HIGH, 7 }, // choice index 7 is 8:1
+                                     { 0, ATTACK_MID, 1 }, { 0, RELEASE_MID, 20 } } },
+            { "solo mid", { { 0, SOLO_MID, 1 }, { 0, THRESHOLD_MID, -24 } } },
+            { "solo low+high", { { 0, SOLO_LOW, 1 }, { 0, SOLO_HIGH, 1 } } },
+            { "mute low", { { 0, MUTE_LOW, 1 }, { 0, THRESHOLD_HIGH, -24 } } },
+            { "bypass high", { { 0, BYPASS_HIGH, 1 }, { 0, THRESHOLD_HIGH, -24 }, { 0, THRESHOLD_LOW, -24 } } },
+            { "muted solo", { { 0, SOLO_LOW, 1 }, { 0, MUTE_LOW, 1 } } },
+            { "global bypass", { { 0, BYPASS_GLOBAL, 1 }, { 0, THRESHOLD_MID, -48 } } },
+        };
+
+        for (const auto& config : configs)
+        {
+            for (const auto& stimulus : stimuli)
+            {
+                auto reference = renderFresh(stimulus.buffer, config.changes, true);
+                auto optimised = renderFresh(stimulus.buffer, config.changes, false);
+                expectMatchesReference(config.name + ", " + stimulus.name, stimulus.buffer, reference, optimised);
+            }
+        }
+    }
+
+    void testToggledConfigurations(const std::vector<Stimulus>& stimuli)
+    {
+        using namespace params;
+
+        const std::vector<ParameterChange> compression =
+        {
+            { 0, THRESHOLD_LOW, -24 }, { 0, THRESHOLD_MID, -24 }, { 0, THRESHOLD_HIGH, -24 },
+        };
+
+        auto toggles = compression;
+        toggles.insert(toggles.end(),
+        {
+            { 40, MUTE_LOW, 1 },
+            { 80, SOLO_MID, 1 },
+            { 120, BYPASS_HIGH, 1 },
+            { 160, MUTE_LOW, 0 },
+            { 200, BYPASS_GLOBAL, 1 },
+            { 240, BYPASS_GLOBAL, 0 },
+            { 280, SOLO_MID, 0 },
+            { 300, SOLO_HIGH, 1 },
+            { 340, SOLO_LOW, 1 },
+            { 380, MUTE_LOW, 1 },
+            { 420, SOLO_LOW, 0 }, { 420, SOLO_HIGH, 0 }, { 420, BYPASS_HIGH, 0 }, { 420, MUTE_LOW, 0 },
+            { 460, BYPASS_MID, 1 }, { 460, MUTE_HIGH, 1 },
+        });
+
+        for (const auto& stimulus : stimuli)
+        {
+            auto reference = renderFresh(stimulus.buffer, toggles, true);
+            auto optimised = renderFresh(stimulus.buffer, toggles, false);
+            expectMatchesReference("toggled, " + stimulus.name, stimulus.buffer, reference, optimised);
+
+            // Guards the schedule itself: if the toggles had no audible effect
+            // the comparison above would prove nothing about re-dispatch.
+            if (stimulus.name != "impulse")
+            {
+                auto untoggled = renderFresh(stimulus.buffer, compression, false);
+                expect(maxAbsDifference(untoggled, optimised) > 1.0e-3f,
+                       "toggled, " + stimulus.name + ": band state changes did not affect the output");
+            }
+        }
+    }
+
+    void testCrossoverFlatness(int numChannels)
+    {
+        using namespace params;
+
+        // Below threshold the compressors leave the bands alone, so the sum
+        // of the three bands must be flat whether or not they are processed.
+        constexpr float quietImpulse = 0.01f;
+        auto impulse = makeImpulse(numChannels, quietImpulse);
+
+        const std::vector<BandConfig> configs =
+        {
+            { "default", {} },
+            { "global bypass", { { 0, BYPASS_GLOBAL, 1 } } },
+        };
+
+        for (const auto& config : configs)
+        {
+            for (auto useReferencePath : { true, false })
+            {
+                auto response = renderFresh(impulse, config.changes, useReferencePath);
+                auto deviation = maxMagnitudeDeviationDb(response, quietImpulse);
+                expect(deviation <= maxCrossoverDeviationDb,
+                       config.name + (useReferencePath ? ", reference" : ", optimised") + ": magnitude deviates "
+                       + juce::String(deviation) + " dB from flat");
+            }
+        }
+    }
+
+    void testChannelCountChanges()
+    {
+        using namespace params;
+
+        auto stereo = makePinkNoise(2);
+        auto mono = makePinkNoise(1);
+
+        const std::vector<ParameterChange> compression =
+        {
+            { 0, THRESHOLD_LOW, -24 }, { 0, THRESHOLD_MID, -24 }, { 0, THRESHOLD_HIGH, -24 },
+        };
+        const std::vector<ParameterChange> soloMid = { { 100, SOLO_MID, 1 } };
+        const std::vector<ParameterChange> unsoloMuteLow = { { 100, SOLO_MID, 0 }, { 200, MUTE_LOW, 1 } };
+
+        ReferenceProcessor reference;
+        SimpleMBCompAudioProcessor optimised;
+
+        // Both instances go stereo -> mono -> stereo, with band changes in
+        // each phase so the dispatch is rebuilt after every re-prepare.
+        auto renderPhase = [&](const juce::String& context, const juce::AudioBuffer<float>& input,
+                               const std::vector<ParameterChange>& changes)
+        {
+            prepare(reference, input.getNumChannels());
+            prepare(optimised, input.getNumChannels());
+            expectMatchesReference(context, input,
+                                   render(reference, input, changes),
+                                   render(optimised, input, changes));
+        };
+
+        renderPhase("stereo", stereo, compression);
+        renderPhase("stereo -> mono", mono, soloMid);
+        renderPhase("mono -> stereo", stereo, unsoloMuteLow);
+    }
+};
+
+static ProcessorVerificationTests processorVerificationTests;